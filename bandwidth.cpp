@@ -12,6 +12,7 @@
 #include <fstream>
 
 #include "gpgpu.hpp"
+#include "kernels.hpp"
 int main()
 {
     try
@@ -24,52 +25,7 @@ int main()
 
         // 0-index = first graphics card, no index(-1)=all gpus
         GPGPU::Computer computer(GPGPU::Computer::DEVICE_GPUS,0);
-        computer.compile(
-            "#define N_BUFFER "+std::to_string(n)+"ull" +R"(
-            )"+
-
-            "#define TEST_PCIE " + std::to_string(testPCIEorVRAM) + R"(
-            )" +
-            "#define TEST_READ " + std::to_string(testREAD) + R"(
-            )" +
-            "#define TEST_WRITE " + std::to_string(testWRITE) + R"(
-            )" +
-
-            R"(
-
-            kernel void bandwidth( 
-                global int * data1,
-                global int * data2) 
-            { 
-                const int threadId=get_global_id(0); 
-
-                // in-kernel data copying to test only VRAM bandwidth
-                if(!TEST_PCIE)
-                {
-                    int data=0;
-                    if(TEST_READ && TEST_WRITE)
-                        for(int i=0;i<N_BUFFER;i+=1024*1024)
-                            data2[threadId + i]=data1[threadId + i];
-                    else if(TEST_READ && !TEST_WRITE)
-                    {
-                        for(int i=0;i<N_BUFFER;i+=1024*1024)
-                        {
-                            data^=data1[threadId + i];
-                        }
-                        data2[threadId]=data;
-                    }
-                    else if(!TEST_READ && TEST_WRITE)
-                        for(int i=0;i<N_BUFFER;i+=1024*1024)
-                            data2[threadId + i]=0;
-
-                    
-                }
-
-
-
-            }
-
-        )", "bandwidth");
+        computer.compile(Kernels::Bandwidth(n, testPCIEorVRAM, testREAD, testWRITE), "bandwidth");
 
         // createArrayState does not make any pcie-transfer. its for keeping states within graphics card
         // createArrayInput: input data of kernel, copied from RAM to VRAM (all elements copied)
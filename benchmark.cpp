@@ -0,0 +1,340 @@
+// runs every example workload through the same harness (benchmarkHarness.hpp) on cpu (cpuReference.hpp) and/or OpenCL
+// usage: benchmark --warmup=10 --repetitions=30 --backend=all --json=result.json --baseline=baseline.json --threshold=0.1
+//      --backend=cpu     : only cpu versions
+//      --backend=opencl  : only OpenCL versions
+//      --backend=all     : both (default)
+//      --backend=auto    : per workload, the faster backend of a short probe (1 warmup + 3 runs each) on this system,
+//                          cpu when OpenCL device is not available
+//      --filter=vecAdd   : only workloads whose name contains "vecAdd"
+// exit code is 1 when any median time is slower than baseline by more than threshold, when a baseline entry
+// selected by --filter/--backend has no result, when OpenCL setup fails under --backend=opencl (or all + baseline),
+// when an OpenCL output differs from cpu reference (checked once after warmup) or on error
+
+#include <iostream>
+#include <fstream>
+#include <memory>
+#include <random>
+
+#include "gpgpu.hpp"
+#include "cpuReference.hpp"
+#include "benchmarkHarness.hpp"
+#include "kernels.hpp"
+
+// timed part of an OpenCL workload and its output check against cpu reference
+struct OpenCLRun
+{
+    std::function<void()> run;
+    std::function<size_t()> mismatches; // empty = output not checked
+};
+
+struct Workload
+{
+    std::string name;
+    Benchmark::Unit unit;
+    double workPerRun;
+    std::function<void()> cpu; // empty = no cpu version
+    std::function<OpenCLRun()> opencl; // creates device state and returns the timed part, empty = no OpenCL version
+};
+
+std::vector<Workload> CreateWorkloads()
+{
+    std::vector<Workload> workloads;
+    std::mt19937 rng{ 12345 };
+
+    // vector add (singleGpuVectorAdd.cpp, singleGpuVectorAddWithScalarParameter.cpp, multiGpuVectorAdd.cpp)
+    {
+        const size_t n = 1024 * 1024 * 16;
+        auto A = std::make_shared<std::vector<int>>(n);
+        auto B = std::make_shared<std::vector<int>>(n);
+        std::uniform_int_distribution<int> uid(0, 1000000);
+        for (auto& e : *B)
+            e = uid(rng);
+
+        workloads.push_back({ "vecAdd", Benchmark::Unit::ElementsPerSecond, (double)n,
+            [=]() { CpuReference::VecAdd(A->data(), B->data(), n); },
+            [=]() -> OpenCLRun {
+                auto computer = std::make_shared<GPGPU::Computer>(GPGPU::Computer::DEVICE_GPUS, 0/*select only first gpu*/);
+                computer->compile(Kernels::VecAdd(), "vecAdd");
+                auto data1 = computer->createArrayOutputAll<int>("A", n);
+                auto data2 = computer->createArrayInput<int>("B", n);
+                data2.copyDataFromPtr(B->data());
+                auto kernelParams = data1.next(data2);
+                return {
+                    [=]() mutable { computer->compute(kernelParams, "vecAdd", 0, n, 256); },
+                    [=]() mutable {
+                        std::vector<int> reference(n);
+                        CpuReference::VecAdd(reference.data(), B->data(), n);
+                        return CpuReference::CountMismatches(&data1.access<int>(0), reference.data(), n);
+                    } };
+            } });
+
+        workloads.push_back({ "vecAddScalar", Benchmark::Unit::ElementsPerSecond, (double)n,
+            [=]() { CpuReference::VecAdd(A->data(), B->data(), 1000, n); },
+            [=]() -> OpenCLRun {
+                auto computer = std::make_shared<GPGPU::Computer>(GPGPU::Computer::DEVICE_GPUS, 0/*select only first gpu*/);
+                computer->compile(Kernels::VecAddScalar(), "vecAdd");
+                auto data1 = computer->createArrayOutputAll<int>("A", n);
+                auto data2 = computer->createArrayInput<int>("B", n);
+                auto scalar = computer->createScalarInput<int>("scalar");
+                data2.copyDataFromPtr(B->data());
+                scalar = 1000;
+                auto kernelParams = data1.next(data2).next(scalar);
+                return {
+                    [=]() mutable { computer->compute(kernelParams, "vecAdd", 0, n, 256); },
+                    [=]() mutable {
+                        std::vector<int> reference(n);
+                        CpuReference::VecAdd(reference.data(), B->data(), 1000, n);
+                        return CpuReference::CountMismatches(&data1.access<int>(0), reference.data(), n);
+                    } };
+            } });
+
+        // all gpus, load-balanced input
+        workloads.push_back({ "vecAddMultiGpu", Benchmark::Unit::ElementsPerSecond, (double)n,
+            nullptr,
+            [=]() -> OpenCLRun {
+                auto computer = std::make_shared<GPGPU::Computer>(GPGPU::Computer::DEVICE_GPUS);
+                computer->compile(Kernels::VecAdd(), "vecAdd");
+                auto data1 = computer->createArrayOutput<int>("A", n);
+                auto data2 = computer->createArrayInputLoadBalanced<int>("B", n);
+                data2.copyDataFromPtr(B->data());
+                auto kernelParams = data1.next(data2);
+                return {
+                    [=]() mutable { computer->compute(kernelParams, "vecAdd", 0, n, 256); },
+                    [=]() mutable {
+                        std::vector<int> reference(n);
+                        CpuReference::VecAdd(reference.data(), B->data(), n);
+                        return CpuReference::CountMismatches(&data1.access<int>(0), reference.data(), n);
+                    } };
+            } });
+    }
+
+    // duplicate removal (duplicateRemoval.cpp)
+    {
+        const int n = 100000;
+        auto input = std::make_shared<std::vector<int>>(n);
+        auto output = std::make_shared<std::vector<int>>(n);
+        std::uniform_int_distribution<int> uid(0, n);
+        for (auto& e : *input)
+            e = uid(rng);
+
+        workloads.push_back({ "findDuplicate", Benchmark::Unit::PairsPerSecond, (double)n * n,
+            [=]() { CpuReference::FindDuplicate(input->data(), output->data(), n); },
+            [=]() -> OpenCLRun {
+                auto computer = std::make_shared<GPGPU::Computer>(GPGPU::Computer::DEVICE_GPUS, 0/*select only first gpu*/);
+                computer->compile(Kernels::FindDuplicate(), "findDuplicate");
+                auto in = computer->createArrayInput<int>("input", n);
+                auto out = computer->createArrayOutputAll<int>("output", n);
+                auto numElements = computer->createScalarInput<int>("numElements");
+                numElements = n;
+                auto kernelParams = in.next(out).next(numElements);
+                // separate output buffer, cpu workload writes into output
+                auto gpuOutput = std::make_shared<std::vector<int>>(n);
+                return {
+                    [=]() mutable {
+                        in.copyDataFromPtr(input->data());
+                        computer->compute(kernelParams, "findDuplicate", 0, n + (256 - (n % 256)), 256);
+                        out.copyDataToPtr(gpuOutput->data());
+                    },
+                    [=]() {
+                        std::vector<int> reference(n);
+                        CpuReference::FindDuplicate(input->data(), reference.data(), n);
+                        return CpuReference::CountMismatches(gpuOutput->data(), reference.data(), n);
+                    } };
+            } });
+
+        workloads.push_back({ "removeDuplicatesFast", Benchmark::Unit::ElementsPerSecond, (double)n,
+            [=]() { *output = CpuReference::RemoveDuplicatesFast(*input); },
+            nullptr });
+    }
+
+    // word neighbors (compare18000words.cpp)
+    {
+        const int numWords = 18000;
+        auto data = std::make_shared<std::vector<char>>();
+        auto start = std::make_shared<std::vector<int>>(numWords);
+        auto length = std::make_shared<std::vector<int>>(numWords);
+        auto matrix = std::make_shared<std::vector<char>>((size_t)numWords * numWords);
+        std::uniform_int_distribution<int> letter('a', 'd');
+        std::uniform_int_distribution<int> wordLength(3, 8);
+        for (int i = 0; i < numWords; i++)
+        {
+            (*start)[i] = (int)data->size();
+            (*length)[i] = wordLength(rng);
+            for (int j = 0; j < (*length)[i]; j++)
+                data->push_back((char)letter(rng));
+        }
+
+        workloads.push_back({ "findNeightbors", Benchmark::Unit::PairsPerSecond, (double)numWords * (numWords - 1) / 2,
+            [=]() { CpuReference::FindNeightbors(data->data(), start->data(), length->data(), matrix->data(), numWords); },
+            [=]() -> OpenCLRun {
+                auto computer = std::make_shared<GPGPU::Computer>(GPGPU::Computer::DEVICE_GPUS, 0/*select only first gpu*/);
+                computer->compile(Kernels::FindNeightbors(numWords), "findNeightbors");
+                auto d = computer->createArrayInput<char>("data", data->size());
+                auto s = computer->createArrayInput<int>("start", numWords);
+                auto l = computer->createArrayInput<int>("length", numWords);
+                auto m = computer->createArrayOutput<char>("matrix", (size_t)numWords * numWords);
+                d.copyDataFromPtr(data->data());
+                s.copyDataFromPtr(start->data());
+                l.copyDataFromPtr(length->data());
+                auto kernelParams = d.next(s).next(l).next(m);
+                return {
+                    [=]() mutable { computer->compute(kernelParams, "findNeightbors", 0, numWords, 180 /* exact divider of numWords */); },
+                    [=]() mutable {
+                        // kernel computes only i<j elements
+                        std::vector<char> reference((size_t)numWords * numWords);
+                        CpuReference::FindNeightbors(data->data(), start->data(), length->data(), reference.data(), numWords);
+                        size_t mismatches = 0;
+                        for (size_t j = 0; j < (size_t)numWords; j++)
+                            for (size_t i = 0; i < j; i++)
+                                mismatches += m.access<char>(i + j * numWords) != reference[i + j * numWords];
+                        return mismatches;
+                    } };
+            } });
+    }
+
+    // vram read+write bandwidth (bandwidth.cpp), OpenCL only
+    {
+        const size_t n = 1024ull * 1024 * 128;
+        workloads.push_back({ "bandwidthVram", Benchmark::Unit::BytesPerSecond, 2.0 * sizeof(int) * n,
+            nullptr,
+            [=]() -> OpenCLRun {
+                auto computer = std::make_shared<GPGPU::Computer>(GPGPU::Computer::DEVICE_GPUS, 0/*select only first gpu*/);
+                computer->compile(Kernels::Bandwidth(n, false /* VRAM */, true, true), "bandwidth");
+                auto data1 = computer->createArrayState<int>("data1", n);
+                auto data2 = computer->createArrayState<int>("data2", n);
+                auto kernelParams = data1.next(data2);
+                return { [=]() mutable { computer->compute(kernelParams, "bandwidth", 0, 1024 * 1024, 1024); }, nullptr };
+            } });
+    }
+
+    return workloads;
+}
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        const Benchmark::Settings settings = Benchmark::ParseArguments(argc, argv);
+        std::cout << "warmup=" << settings.warmup << " repetitions=" << settings.repetitions << " backend=" << settings.backend
+            << " cpu simd=" << CpuReference::SimdLevelName(CpuReference::BestSimdLevel())
+            << " (findNeightbors: " << CpuReference::SimdLevelName(CpuReference::NeightborsSimdLevel()) << ")" << std::endl;
+        std::cout << "-------------------------------------------------" << std::endl;
+
+        // loaded before running so that an unreadable baseline fails early
+        std::vector<Benchmark::Result> baseline;
+        if (!settings.baselineFile.empty())
+            baseline = Benchmark::LoadBaseline(settings.baselineFile);
+
+        const std::vector<Workload> workloads = CreateWorkloads();
+        auto filteredOut = [&](const std::string& name) {
+            return !settings.filter.empty() && name.find(settings.filter) == std::string::npos;
+        };
+        if (std::all_of(workloads.begin(), workloads.end(), [&](const Workload& w) { return filteredOut(w.name); }))
+            throw std::runtime_error("--filter=" + settings.filter + " matches no workload");
+
+        std::vector<Benchmark::Result> results;
+        std::vector<std::pair<std::string, std::string>> selected; // (name, backend) pairs this run intends to measure
+        bool failed = false;
+        for (const Workload& w : workloads)
+        {
+            if (filteredOut(w.name))
+                continue;
+
+            const bool isAuto = settings.backend == "auto";
+            const bool wantCpu = w.cpu && (settings.backend == "cpu" || settings.backend == "all" || isAuto);
+            const bool wantOpenCL = w.opencl && (settings.backend == "opencl" || settings.backend == "all" || isAuto);
+
+            OpenCLRun work;
+            bool openCLFailed = false;
+            if (wantOpenCL)
+            {
+                try
+                {
+                    work = w.opencl();
+                }
+                catch (std::exception& ex)
+                {
+                    // auto falls back to cpu, explicitly requested OpenCL measurements can not be skipped
+                    const bool required = settings.backend == "opencl" || (settings.backend == "all" && !baseline.empty());
+                    std::cout << (required ? "error: " : "") << w.name << ": OpenCL not available (" << ex.what() << ")" << std::endl;
+                    failed = failed || required;
+                    openCLFailed = true;
+                }
+            }
+
+            bool runCpu = wantCpu;
+            bool runOpenCL = (bool)work.run;
+            if (isAuto && runCpu && runOpenCL)
+            {
+                // auto: short probe of both backends on this system, only the faster one is measured
+                Benchmark::Settings probe = settings;
+                probe.warmup = 1;
+                probe.repetitions = 3;
+                const double cpuSeconds = Benchmark::Run(w.name, "cpu", w.unit, w.workPerRun, probe, w.cpu).median;
+                const double openCLSeconds = Benchmark::Run(w.name, "opencl", w.unit, w.workPerRun, probe, work.run).median;
+                runCpu = cpuSeconds < openCLSeconds;
+                runOpenCL = !runCpu;
+                std::cout << w.name << ": auto probe cpu=" << cpuSeconds * 1000.0 << "ms opencl=" << openCLSeconds * 1000.0
+                    << "ms -> " << (runCpu ? "cpu" : "opencl") << std::endl;
+            }
+
+            // a planned OpenCL measurement whose setup failed stays selected so that its baseline entry is reported missing
+            if (runCpu)
+                selected.emplace_back(w.name, "cpu");
+            if (runOpenCL || openCLFailed)
+                selected.emplace_back(w.name, "opencl");
+
+            if (runOpenCL)
+            {
+                results.push_back(Benchmark::Run(w.name, "opencl", w.unit, w.workPerRun, settings, work.run, work.mismatches));
+                Benchmark::Print(results.back());
+                if (results.back().mismatches > 0)
+                {
+                    std::cout << "error: " << w.name << " OpenCL output differs from cpu reference" << std::endl;
+                    failed = true;
+                }
+            }
+            if (runCpu)
+            {
+                results.push_back(Benchmark::Run(w.name, "cpu", w.unit, w.workPerRun, settings, w.cpu));
+                Benchmark::Print(results.back());
+            }
+        }
+
+        if (!settings.jsonFile.empty())
+        {
+            std::ofstream json(settings.jsonFile);
+            json << Benchmark::ToJson(results);
+            if (!json)
+                throw std::runtime_error("can not write " + settings.jsonFile);
+            std::cout << "results written to " << settings.jsonFile << std::endl;
+        }
+
+        if (!settings.baselineFile.empty())
+        {
+            // baseline entries of workloads removed by --filter or of backends not selected by --backend are skipped,
+            // entries of unknown workloads and selected measurements without a result fail
+            auto excluded = [&](const Benchmark::Result& b) {
+                if (filteredOut(b.name))
+                    return true;
+                const bool known = std::any_of(workloads.begin(), workloads.end(), [&](const Workload& w) { return w.name == b.name; });
+                return known && std::find(selected.begin(), selected.end(), std::make_pair(b.name, b.backend)) == selected.end();
+            };
+            const bool passed = Benchmark::CompareWithBaseline(results, baseline, settings.regressionThreshold, excluded);
+            if (!passed)
+            {
+                std::cout << "performance regression or missing result detected" << std::endl;
+                failed = true;
+            }
+        }
+
+        if (failed)
+            return 1;
+    }
+    catch (std::exception& ex)
+    {
+        std::cout << ex.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
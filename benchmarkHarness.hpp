@@ -0,0 +1,347 @@
+// shared benchmark harness: warmup + N timed repetitions, median / MAD / p99, throughput,
+// JSON output and comparison against a stored baseline JSON (fails when median time regresses over a threshold)
+// does not need gpgpu.hpp, workloads are plain std::function<void()>
+
+#ifndef BENCHMARK_HARNESS_HPP
+#define BENCHMARK_HARNESS_HPP
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <functional>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace Benchmark
+{
+    enum class Unit { ElementsPerSecond, PairsPerSecond, BytesPerSecond };
+
+    inline const char* UnitName(Unit unit)
+    {
+        switch (unit)
+        {
+        case Unit::PairsPerSecond: return "pairs/s";
+        case Unit::BytesPerSecond: return "GB/s";
+        default: return "elements/s";
+        }
+    }
+
+    struct Settings
+    {
+        int warmup = 10;
+        int repetitions = 30;
+        double regressionThreshold = 0.10; // 0.10 = fail when median time is 10% slower than baseline
+        std::string backend = "all";       // cpu, opencl, all, auto (auto = faster backend of a short probe per workload)
+        std::string filter;                // runs only workloads whose name contains this
+        std::string jsonFile;
+        std::string baselineFile;
+    };
+
+    struct Result
+    {
+        std::string name;
+        std::string backend;
+        Unit unit = Unit::ElementsPerSecond;
+        double workPerRun = 0; // elements, pairs or bytes processed by one run
+        std::vector<double> seconds;
+        double median = 0;
+        double mad = 0;
+        double p99 = 0;
+        bool verified = false;  // output was compared against a reference after warmup
+        size_t mismatches = 0;
+
+        // per second, GB/s for bytes
+        double Throughput() const
+        {
+            const double perSecond = median > 0 ? workPerRun / median : 0;
+            return unit == Unit::BytesPerSecond ? perSecond / 1000000000.0 : perSecond;
+        }
+    };
+
+    inline double Median(std::vector<double> v)
+    {
+        if (v.empty())
+            return 0;
+        std::sort(v.begin(), v.end());
+        const size_t n = v.size();
+        return (n % 2) ? v[n / 2] : 0.5 * (v[n / 2 - 1] + v[n / 2]);
+    }
+
+    // nearest-rank percentile
+    inline double Percentile(std::vector<double> v, const double p)
+    {
+        if (v.empty())
+            return 0;
+        std::sort(v.begin(), v.end());
+        size_t rank = (size_t)std::ceil(p / 100.0 * v.size());
+        rank = std::min(std::max(rank, size_t(1)), v.size());
+        return v[rank - 1];
+    }
+
+    // verify (optional) runs once after warmup and returns number of output elements that differ from a reference
+    inline Result Run(const std::string& name, const std::string& backend, const Unit unit, const double workPerRun, const Settings& settings,
+        const std::function<void()>& work, const std::function<size_t()>& verify = nullptr)
+    {
+        Result result;
+        result.name = name;
+        result.backend = backend;
+        result.unit = unit;
+        result.workPerRun = workPerRun;
+
+        for (int i = 0; i < settings.warmup; i++)
+            work();
+
+        if (verify)
+        {
+            if (settings.warmup <= 0)
+                work();
+            result.verified = true;
+            result.mismatches = verify();
+        }
+
+        for (int i = 0; i < settings.repetitions; i++)
+        {
+            const auto t0 = std::chrono::steady_clock::now();
+            work();
+            const auto t1 = std::chrono::steady_clock::now();
+            result.seconds.push_back(std::chrono::duration<double>(t1 - t0).count());
+        }
+
+        result.median = Median(result.seconds);
+        std::vector<double> deviations;
+        for (double s : result.seconds)
+            deviations.push_back(std::fabs(s - result.median));
+        result.mad = Median(deviations);
+        result.p99 = Percentile(result.seconds, 99);
+        return result;
+    }
+
+    inline void Print(const Result& r)
+    {
+        std::cout << std::left << std::setw(22) << r.name << std::setw(8) << r.backend << std::right
+            << " median=" << std::setw(10) << std::setprecision(4) << r.median * 1000.0 << "ms"
+            << " mad=" << std::setw(9) << std::setprecision(3) << r.mad * 1000.0 << "ms"
+            << " p99=" << std::setw(10) << std::setprecision(4) << r.p99 * 1000.0 << "ms"
+            << "  " << std::setprecision(4) << r.Throughput() << " " << UnitName(r.unit);
+        if (r.verified)
+            std::cout << "  mismatches=" << r.mismatches;
+        std::cout << std::endl;
+    }
+
+    inline std::string ToJson(const std::vector<Result>& results)
+    {
+        std::ostringstream out;
+        out << std::setprecision(9);
+        out << "{\n  \"results\": [\n";
+        for (size_t i = 0; i < results.size(); i++)
+        {
+            const Result& r = results[i];
+            out << "    { \"name\": \"" << r.name << "\", \"backend\": \"" << r.backend << "\""
+                << ", \"unit\": \"" << UnitName(r.unit) << "\""
+                << ", \"repetitions\": " << r.seconds.size()
+                << ", \"median_seconds\": " << r.median
+                << ", \"mad_seconds\": " << r.mad
+                << ", \"p99_seconds\": " << r.p99
+                << ", \"throughput\": " << r.Throughput();
+            if (r.verified)
+                out << ", \"mismatches\": " << r.mismatches;
+            out << " }"
+                << (i + 1 < results.size() ? ",\n" : "\n");
+        }
+        out << "  ]\n}\n";
+        return out.str();
+    }
+
+    namespace Detail
+    {
+        // reads "key": "value" or "key": number from one JSON object text (only for files written by ToJson)
+        inline std::string Field(const std::string& object, const std::string& key)
+        {
+            const std::string pattern = "\"" + key + "\"";
+            size_t pos = object.find(pattern);
+            if (pos == std::string::npos)
+                return "";
+            pos = object.find(':', pos + pattern.size());
+            if (pos == std::string::npos)
+                return "";
+            pos = object.find_first_not_of(" \t\r\n", pos + 1);
+            if (pos == std::string::npos)
+                return "";
+            if (object[pos] == '"')
+            {
+                const size_t end = object.find('"', pos + 1);
+                return end == std::string::npos ? "" : object.substr(pos + 1, end - pos - 1);
+            }
+            const size_t end = object.find_first_of(",} \t\r\n", pos);
+            return object.substr(pos, end - pos);
+        }
+
+        // whole text must be a finite number, returns false otherwise
+        inline bool ParseDouble(const std::string& text, double& value)
+        {
+            try
+            {
+                size_t used = 0;
+                value = std::stod(text, &used);
+                return used == text.size() && std::isfinite(value);
+            }
+            catch (std::exception&)
+            {
+                return false;
+            }
+        }
+
+        // whole text must be an int, returns false otherwise
+        inline bool ParseInt(const std::string& text, int& value)
+        {
+            try
+            {
+                size_t used = 0;
+                value = std::stoi(text, &used);
+                return used == text.size();
+            }
+            catch (std::exception&)
+            {
+                return false;
+            }
+        }
+    }
+
+    // loads name, backend and median_seconds of each result in a JSON file written by ToJson
+    // throws if there is no entry or an entry has no backend or no positive median
+    inline std::vector<Result> LoadBaseline(const std::string& fileName)
+    {
+        std::ifstream file(fileName);
+        if (!file)
+            throw std::runtime_error("Benchmark::LoadBaseline: can not open " + fileName);
+        std::stringstream text;
+        text << file.rdbuf();
+        const std::string json = text.str();
+
+        std::vector<Result> results;
+        size_t pos = json.find('[');
+        while (pos != std::string::npos && (pos = json.find('{', pos)) != std::string::npos)
+        {
+            const size_t end = json.find('}', pos);
+            if (end == std::string::npos)
+                break;
+            const std::string object = json.substr(pos, end - pos + 1);
+            Result r;
+            r.name = Detail::Field(object, "name");
+            r.backend = Detail::Field(object, "backend");
+            if (!r.name.empty())
+            {
+                const std::string median = Detail::Field(object, "median_seconds");
+                if (r.backend.empty() || !Detail::ParseDouble(median, r.median) || r.median <= 0)
+                    throw std::runtime_error("Benchmark::LoadBaseline: entry " + r.name + " (" + r.backend + ") in " + fileName
+                        + " needs a backend and a positive median_seconds, found \"" + median + "\"");
+                results.push_back(r);
+            }
+            pos = end + 1;
+        }
+        if (results.empty())
+            throw std::runtime_error("Benchmark::LoadBaseline: no results found in " + fileName);
+        return results;
+    }
+
+    // prints time change of each result that has a baseline entry (same name + backend)
+    // returns false if any median time is slower than baseline by more than threshold, or if a baseline entry
+    // has no result (unless excluded(entry) tells that this run did not select it, for example by --filter)
+    // or if no result could be compared at all
+    inline bool CompareWithBaseline(const std::vector<Result>& results, const std::vector<Result>& baseline, const double threshold,
+        const std::function<bool(const Result&)>& excluded = nullptr)
+    {
+        bool passed = true;
+        size_t compared = 0;
+        std::cout << "-------------------------------------------------" << std::endl;
+        std::cout << "baseline comparison (threshold = " << threshold * 100.0 << "%)" << std::endl;
+        for (const Result& r : results)
+        {
+            auto it = std::find_if(baseline.begin(), baseline.end(), [&](const Result& b) {
+                return b.name == r.name && b.backend == r.backend;
+            });
+            if (it == baseline.end())
+            {
+                std::cout << std::left << std::setw(22) << r.name << std::setw(8) << r.backend << " no baseline" << std::endl;
+                continue;
+            }
+            compared++;
+            const double change = r.median / it->median - 1.0;
+            const bool regressed = change > threshold;
+            passed = passed && !regressed;
+            std::cout << std::left << std::setw(22) << r.name << std::setw(8) << r.backend << std::right
+                << std::showpos << std::setprecision(3) << change * 100.0 << std::noshowpos << "%"
+                << (regressed ? "  REGRESSION" : "") << std::endl;
+        }
+        for (const Result& b : baseline)
+        {
+            auto it = std::find_if(results.begin(), results.end(), [&](const Result& r) {
+                return b.name == r.name && b.backend == r.backend;
+            });
+            if (it != results.end() || (excluded && excluded(b)))
+                continue;
+            passed = false;
+            std::cout << std::left << std::setw(22) << b.name << std::setw(8) << b.backend << " MISSING (in baseline, no result)" << std::endl;
+        }
+        if (compared == 0)
+        {
+            passed = false;
+            std::cout << "no result has a baseline entry, nothing was compared" << std::endl;
+        }
+        return passed;
+    }
+
+    // --warmup=N --repetitions=N --threshold=0.1 --backend=cpu|opencl|all|auto --filter=name --json=file --baseline=file
+    inline Settings ParseArguments(int argc, char** argv)
+    {
+        const std::string usage = "usage: --warmup=N --repetitions=N --threshold=0.1 --backend=cpu|opencl|all|auto --filter=name --json=file --baseline=file";
+        auto invalid = [&](const std::string& arg, const std::string& expected) {
+            return std::runtime_error("invalid value: " + arg + " (expected " + expected + ")\n" + usage);
+        };
+
+        Settings settings;
+        for (int i = 1; i < argc; i++)
+        {
+            const std::string arg = argv[i];
+            const size_t eq = arg.find('=');
+            const std::string key = arg.substr(0, eq);
+            const std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+            if (key == "--warmup")
+            {
+                if (!Detail::ParseInt(value, settings.warmup) || settings.warmup < 0)
+                    throw invalid(arg, "integer >= 0");
+            }
+            else if (key == "--repetitions")
+            {
+                if (!Detail::ParseInt(value, settings.repetitions) || settings.repetitions < 1)
+                    throw invalid(arg, "integer >= 1");
+            }
+            else if (key == "--threshold")
+            {
+                if (!Detail::ParseDouble(value, settings.regressionThreshold) || settings.regressionThreshold < 0)
+                    throw invalid(arg, "fraction >= 0, 0.1 = 10%");
+            }
+            else if (key == "--backend")
+                settings.backend = value;
+            else if (key == "--filter")
+                settings.filter = value;
+            else if (key == "--json")
+                settings.jsonFile = value;
+            else if (key == "--baseline")
+                settings.baselineFile = value;
+            else
+                throw std::runtime_error("unknown argument: " + arg + "\n" + usage);
+        }
+        if (settings.backend != "cpu" && settings.backend != "opencl" && settings.backend != "all" && settings.backend != "auto")
+            throw std::runtime_error("unknown backend: " + settings.backend + " (cpu, opencl, all, auto)");
+        return settings;
+    }
+}
+
+#endif // BENCHMARK_HARNESS_HPP
@@ -1,10 +1,13 @@
 // compares 18000 words with each other and outputs a binary matrix where 1 = within 1 letter difference, 0 = different
 // rtx4070: 8 milliseconds, including data-copy through pcie bridge (pcie v4.0 x16 bandwidth)
+//          (measured before the kernel loaded all letters of each word instead of only the first one, not re-measured yet)
 
 #include <iostream>
 #include <fstream>
 
 #include "gpgpu.hpp"
+#include "cpuReference.hpp"
+#include "kernels.hpp"
 int main()
 {
 
@@ -16,63 +19,7 @@ int main()
         GPGPU::Computer computer(GPGPU::Computer::DEVICE_GPUS); 
 
 
-        computer.compile(
-            
-            R"(
-
-            kernel void findNeightbors( 
-                global char * data,
-                global int * start,
-                global int * length,
-                global char * matrix) 
-            { 
-                const int threadId=get_global_id(0); 
-                const int wStart1 = start[threadId];
-                const int wLength1 = length[threadId];
-                const int wEnd1 = wStart1+wLength1;
-                // assuming 20 letters are enough for longest word
-                char localWord1[20];
-                char localWord2[20];
-
-                // load word1 into registers
-                for(int i=wStart1;i<wEnd1;i++)
-                {
-                    localWord1[i-wStart1]=data[wStart1];
-                }
-    
-                for(int j=0;j<18000;j++)
-                {
-                    const int wStart2 = start[j];
-                    const int wLength2 = length[j];
-                    const int wEnd2 = wStart2+wLength2;
-                    // load word2 into local memory
-                    for(int i=wStart2;i<wEnd2;i++)
-                    {
-                        localWord2[i-wStart2]=data[wStart2];
-                    }
-
-                    // compare
-                    const int nLow = wLength1 < wLength2 ? wLength1 : wLength2;
-                    int diff = abs(wLength1 - wLength2);
-                    for(int i=0;i<nLow;i++)
-                        diff += localWord1[i] != localWord2[i];
-
-                    // need to copy (i,j) to (j,i) later because they are same
-                    if(threadId<j)
-                    {
-                        if(diff>1)
-                        {
-                            matrix[threadId + j*18000]=0;
-                        }
-                        else
-                        {
-                            matrix[threadId + j*18000]=1;
-                        }
-                    }
-                }
-
-
-             })", "findNeightbors");
+        computer.compile(Kernels::FindNeightbors(numWords), "findNeightbors");
                 
         auto data = computer.createArrayInput<char>("data", bufferSize);        
         auto start = computer.createArrayInput<int>("start", numWords);
@@ -107,6 +54,20 @@ int main()
             }
             std::cout << nanoSeconds / 1000000000.0f << " seconds" << std::endl; 
         }
+
+        // cross-check against cpu reference (only i<j elements are computed by kernel)
+        std::vector<char> reference((size_t)numWords * numWords);
+        size_t nanoSecondsCpu;
+        {
+            GPGPU::Bench bench(&nanoSecondsCpu);
+            CpuReference::FindNeightbors(&data.access<char>(0), &start.access<int>(0), &length.access<int>(0), reference.data(), numWords);
+        }
+        size_t mismatches = 0;
+        for (size_t j = 0; j < (size_t)numWords; j++)
+            for (size_t i = 0; i < j; i++)
+                mismatches += matrix.access<char>(i + j * numWords) != reference[i + j * numWords];
+        std::cout << "cpu reference (" << CpuReference::SimdLevelName(CpuReference::NeightborsSimdLevel()) << ") = " << nanoSecondsCpu / 1000000000.0f << " seconds" << std::endl;
+        std::cout << "mismatches vs cpu reference = " << mismatches << std::endl;
         
 
     }
@@ -0,0 +1,502 @@
+// native C++ versions of the example kernels (vecAdd, findDuplicate, findNeightbors)
+// used as a correctness oracle (outputs are element-by-element comparable to kernel outputs)
+// and as a cpu fallback for small work sizes where pcie transfer + kernel launch costs more than the computation
+// AVX-512 / AVX2 / scalar code paths are selected at runtime, work is spread over std::thread
+// does not need gpgpu.hpp, does not need -mavx2 / -mavx512f compiler flags
+
+#ifndef CPU_REFERENCE_HPP
+#define CPU_REFERENCE_HPP
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#include <immintrin.h>
+#define CPU_REFERENCE_X86 1
+#define CPU_REFERENCE_TARGET(x)
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define CPU_REFERENCE_X86 1
+#define CPU_REFERENCE_TARGET(x) __attribute__((target(x)))
+#else
+#define CPU_REFERENCE_X86 0
+#define CPU_REFERENCE_TARGET(x)
+#endif
+
+namespace CpuReference
+{
+    enum class SimdLevel { Scalar = 0, Avx2 = 1, Avx512 = 2 };
+
+    // findNeightbors kernel keeps words in char[maxWordLength] private arrays (passed to kernel as MAX_WORD_LENGTH)
+    constexpr int maxWordLength = 20;
+
+    inline const char* SimdLevelName(SimdLevel level)
+    {
+        switch (level)
+        {
+        case SimdLevel::Avx512: return "avx512";
+        case SimdLevel::Avx2: return "avx2";
+        default: return "scalar";
+        }
+    }
+
+    // queries cpu + os support once, later calls return cached value
+    inline SimdLevel BestSimdLevel()
+    {
+        static const SimdLevel level = []() {
+#if CPU_REFERENCE_X86 && defined(_MSC_VER)
+            int info[4];
+            __cpuid(info, 0);
+            const int maxLeaf = info[0];
+            if (maxLeaf < 7)
+                return SimdLevel::Scalar;
+            __cpuid(info, 1);
+            const bool osxsave = (info[2] & (1 << 27)) != 0;
+            if (!osxsave)
+                return SimdLevel::Scalar;
+            const unsigned long long xcr0 = _xgetbv(0);
+            const bool ymmState = (xcr0 & 0x6) == 0x6;
+            const bool zmmState = (xcr0 & 0xe6) == 0xe6;
+            __cpuidex(info, 7, 0);
+            const bool avx2 = (info[1] & (1 << 5)) != 0;
+            const bool avx512f = (info[1] & (1 << 16)) != 0;
+            if (avx512f && zmmState)
+                return SimdLevel::Avx512;
+            if (avx2 && ymmState)
+                return SimdLevel::Avx2;
+            return SimdLevel::Scalar;
+#elif CPU_REFERENCE_X86
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx512f"))
+                return SimdLevel::Avx512;
+            if (__builtin_cpu_supports("avx2"))
+                return SimdLevel::Avx2;
+            return SimdLevel::Scalar;
+#else
+            return SimdLevel::Scalar;
+#endif
+        }();
+        return level;
+    }
+
+    // byte compares of avx512 (findNeightbors) need avx512bw on top of avx512f
+    inline bool HasAvx512Bw()
+    {
+        static const bool supported = []() {
+#if CPU_REFERENCE_X86 && defined(_MSC_VER)
+            if (BestSimdLevel() != SimdLevel::Avx512)
+                return false;
+            int info[4];
+            __cpuidex(info, 7, 0);
+            return (info[1] & (1 << 30)) != 0;
+#elif CPU_REFERENCE_X86
+            __builtin_cpu_init();
+            return BestSimdLevel() == SimdLevel::Avx512 && __builtin_cpu_supports("avx512bw");
+#else
+            return false;
+#endif
+        }();
+        return supported;
+    }
+
+    // simd level FindNeightbors actually runs with when asked for level
+    inline SimdLevel NeightborsSimdLevel(const SimdLevel level = BestSimdLevel())
+    {
+        if (level == SimdLevel::Avx512 && !HasAvx512Bw())
+            return SimdLevel::Avx2;
+        return level;
+    }
+
+    namespace Detail
+    {
+        // runs work(begin,end) on chunks of [0,n) pulled from a shared counter (balances uneven per-element costs)
+        // single-threaded when there is not enough work to pay for thread creation
+        template<typename F>
+        void ParallelFor(const size_t n, const size_t grain, F&& work)
+        {
+            const size_t hw = std::max(1u, std::thread::hardware_concurrency());
+            const size_t thr = std::min(hw, (n + grain - 1) / grain);
+            if (thr <= 1)
+            {
+                if (n > 0)
+                    work(size_t(0), n);
+                return;
+            }
+
+            std::atomic<size_t> next{ 0 };
+            auto worker = [&]() {
+                size_t begin;
+                while ((begin = next.fetch_add(grain)) < n)
+                    work(begin, std::min(begin + grain, n));
+            };
+            std::vector<std::thread> threads;
+            for (size_t t = 1; t < thr; t++)
+                threads.emplace_back(worker);
+            worker();
+            for (auto& t : threads)
+                t.join();
+        }
+
+        inline int HighestBit(unsigned int mask)
+        {
+#if defined(_MSC_VER)
+            unsigned long index;
+            _BitScanReverse(&index, mask);
+            return (int)index;
+#else
+            return 31 - __builtin_clz(mask);
+#endif
+        }
+
+        inline int PopCount(unsigned int mask)
+        {
+#if defined(_MSC_VER)
+            int result = 0;
+            for (; mask; mask &= mask - 1)
+                result++;
+            return result;
+#else
+            return __builtin_popcount(mask);
+#endif
+        }
+
+        // ---------------- vecAdd ----------------
+
+        // int addition that wraps on overflow like the kernel and _mm256/_mm512_add_epi32 (signed overflow is undefined in C++)
+        inline int WrappingAdd(const int a, const int b)
+        {
+            return (int)((unsigned int)a + (unsigned int)b);
+        }
+
+        inline void VecAddScalar(int* A, const int* B, const int scalar, const size_t begin, const size_t end)
+        {
+            for (size_t i = begin; i < end; i++)
+                A[i] = WrappingAdd(B[i], scalar);
+        }
+
+#if CPU_REFERENCE_X86
+        CPU_REFERENCE_TARGET("avx2")
+        inline void VecAddAvx2(int* A, const int* B, const int scalar, const size_t begin, const size_t end)
+        {
+            const __m256i s = _mm256_set1_epi32(scalar);
+            size_t i = begin;
+            for (; i + 8 <= end; i += 8)
+            {
+                const __m256i b = _mm256_loadu_si256((const __m256i*)(B + i));
+                _mm256_storeu_si256((__m256i*)(A + i), _mm256_add_epi32(b, s));
+            }
+            for (; i < end; i++)
+                A[i] = WrappingAdd(B[i], scalar);
+        }
+
+        CPU_REFERENCE_TARGET("avx512f")
+        inline void VecAddAvx512(int* A, const int* B, const int scalar, const size_t begin, const size_t end)
+        {
+            const __m512i s = _mm512_set1_epi32(scalar);
+            size_t i = begin;
+            for (; i + 16 <= end; i += 16)
+            {
+                const __m512i b = _mm512_loadu_si512((const void*)(B + i));
+                _mm512_storeu_si512((void*)(A + i), _mm512_add_epi32(b, s));
+            }
+            for (; i < end; i++)
+                A[i] = WrappingAdd(B[i], scalar);
+        }
+#endif
+
+        // ---------------- findDuplicate ----------------
+        // kernel scans input in blocks of 256, stops at first block that contains val and
+        // keeps the last matching index of that block. same rule is applied here so outputs are identical
+
+        inline int FirstIndexScalar(const int* input, const int n, const int val)
+        {
+            for (int c = 0; c < n; c += 256)
+            {
+                const int end = std::min(c + 256, n);
+                int last = -1;
+                for (int j = c; j < end; j++)
+                    if (input[j] == val)
+                        last = j;
+                if (last >= 0)
+                    return last;
+            }
+            return -1;
+        }
+
+#if CPU_REFERENCE_X86
+        CPU_REFERENCE_TARGET("avx2")
+        inline int FirstIndexAvx2(const int* input, const int n, const int val)
+        {
+            const __m256i v = _mm256_set1_epi32(val);
+            for (int c = 0; c < n; c += 256)
+            {
+                const int end = std::min(c + 256, n);
+                int last = -1;
+                int j = c;
+                for (; j + 8 <= end; j += 8)
+                {
+                    const __m256i x = _mm256_loadu_si256((const __m256i*)(input + j));
+                    const unsigned int mask = (unsigned int)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(x, v)));
+                    if (mask)
+                        last = j + HighestBit(mask);
+                }
+                for (; j < end; j++)
+                    if (input[j] == val)
+                        last = j;
+                if (last >= 0)
+                    return last;
+            }
+            return -1;
+        }
+
+        CPU_REFERENCE_TARGET("avx512f")
+        inline int FirstIndexAvx512(const int* input, const int n, const int val)
+        {
+            const __m512i v = _mm512_set1_epi32(val);
+            for (int c = 0; c < n; c += 256)
+            {
+                const int end = std::min(c + 256, n);
+                int last = -1;
+                int j = c;
+                for (; j + 16 <= end; j += 16)
+                {
+                    const __m512i x = _mm512_loadu_si512((const void*)(input + j));
+                    const unsigned int mask = (unsigned int)_mm512_cmpeq_epi32_mask(x, v);
+                    if (mask)
+                        last = j + HighestBit(mask);
+                }
+                for (; j < end; j++)
+                    if (input[j] == val)
+                        last = j;
+                if (last >= 0)
+                    return last;
+            }
+            return -1;
+        }
+#endif
+
+        // ---------------- findNeightbors ----------------
+        // words are packed into zero-padded 32-byte slots (one simd load per word). kernel's "diff" is
+        // abs(length1-length2) + letter differences within shorter length, so byte comparisons are masked
+        // to the shorter length (words may contain any byte including '\0')
+
+        constexpr int wordSlot = 32;
+        static_assert(maxWordLength <= wordSlot, "words must fit into zero-padded slots");
+
+        inline int WordDiffScalar(const unsigned char* w1, const int length1, const unsigned char* w2, const int length2)
+        {
+            const int nLow = std::min(length1, length2);
+            int diff = std::abs(length1 - length2);
+            for (int i = 0; i < nLow; i++)
+                diff += w1[i] != w2[i];
+            return diff;
+        }
+
+        // bit k set for k < length (length <= maxWordLength < 32)
+        inline unsigned int LengthMask(const int length)
+        {
+            return (1u << length) - 1u;
+        }
+
+        inline void NeighborColumnsScalar(const unsigned char* words, const int* lengths, char* matrix, const int numWords, const size_t begin, const size_t end)
+        {
+            for (size_t j = begin; j < end; j++)
+            {
+                const unsigned char* w2 = words + j * wordSlot;
+                char* column = matrix + j * (size_t)numWords;
+                for (size_t i = 0; i < j; i++)
+                    column[i] = (WordDiffScalar(words + i * wordSlot, lengths[i], w2, lengths[j]) > 1) ? 0 : 1;
+            }
+        }
+
+#if CPU_REFERENCE_X86
+        CPU_REFERENCE_TARGET("avx2,popcnt")
+        inline void NeighborColumnsAvx2(const unsigned char* words, const int* lengths, char* matrix, const int numWords, const size_t begin, const size_t end)
+        {
+            for (size_t j = begin; j < end; j++)
+            {
+                const __m256i w2 = _mm256_loadu_si256((const __m256i*)(words + j * wordSlot));
+                const int length2 = lengths[j];
+                char* column = matrix + j * (size_t)numWords;
+                for (size_t i = 0; i < j; i++)
+                {
+                    const __m256i w1 = _mm256_loadu_si256((const __m256i*)(words + i * wordSlot));
+                    const unsigned int equal = (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(w1, w2));
+                    const int length1 = lengths[i];
+                    const int diff = PopCount(~equal & LengthMask(std::min(length1, length2))) + std::abs(length1 - length2);
+                    column[i] = (diff > 1) ? 0 : 1;
+                }
+            }
+        }
+
+        // compares two consecutive words (64 bytes) with same word per instruction
+        CPU_REFERENCE_TARGET("avx512f,avx512bw,popcnt")
+        inline void NeighborColumnsAvx512(const unsigned char* words, const int* lengths, char* matrix, const int numWords, const size_t begin, const size_t end)
+        {
+            for (size_t j = begin; j < end; j++)
+            {
+                const unsigned char* word2 = words + j * wordSlot;
+                // word2 twice, once per 32-byte half
+                unsigned char pair[2 * wordSlot];
+                std::memcpy(pair, word2, wordSlot);
+                std::memcpy(pair + wordSlot, word2, wordSlot);
+                const __m512i w2 = _mm512_loadu_si512((const void*)pair);
+                const int length2 = lengths[j];
+                char* column = matrix + j * (size_t)numWords;
+                size_t i = 0;
+                for (; i + 2 <= j; i += 2)
+                {
+                    const __m512i w1 = _mm512_loadu_si512((const void*)(words + i * wordSlot));
+                    const unsigned long long equal = (unsigned long long)_mm512_cmpeq_epi8_mask(w1, w2);
+                    const int length1a = lengths[i];
+                    const int length1b = lengths[i + 1];
+                    const int diffA = PopCount(~(unsigned int)equal & LengthMask(std::min(length1a, length2))) + std::abs(length1a - length2);
+                    const int diffB = PopCount(~(unsigned int)(equal >> 32) & LengthMask(std::min(length1b, length2))) + std::abs(length1b - length2);
+                    column[i] = (diffA > 1) ? 0 : 1;
+                    column[i + 1] = (diffB > 1) ? 0 : 1;
+                }
+                for (; i < j; i++)
+                    column[i] = (WordDiffScalar(words + i * wordSlot, lengths[i], word2, length2) > 1) ? 0 : 1;
+            }
+        }
+#endif
+    }
+
+    // A[i] = B[i] + scalar  (vecAdd kernel with scalar parameter)
+    inline void VecAdd(int* A, const int* B, const int scalar, const size_t n, const SimdLevel level = BestSimdLevel())
+    {
+        Detail::ParallelFor(n, 1024 * 256, [&](size_t begin, size_t end) {
+#if CPU_REFERENCE_X86
+            if (level == SimdLevel::Avx512)
+                Detail::VecAddAvx512(A, B, scalar, begin, end);
+            else if (level == SimdLevel::Avx2)
+                Detail::VecAddAvx2(A, B, scalar, begin, end);
+            else
+#endif
+                Detail::VecAddScalar(A, B, scalar, begin, end);
+        });
+    }
+
+    // A[i] = B[i] + 1  (vecAdd kernel without scalar parameter)
+    inline void VecAdd(int* A, const int* B, const size_t n, const SimdLevel level = BestSimdLevel())
+    {
+        VecAdd(A, B, 1, n, level);
+    }
+
+    // brute-force O(N^2) duplicate marking, same output as findDuplicate kernel:
+    // output[i] = input[i] for the chosen representative of each value, -1 for the other copies
+    // input elements are expected to be non-negative (-1 is the "removed" marker)
+    inline void FindDuplicate(const int* input, int* output, const int numElements, const SimdLevel level = BestSimdLevel())
+    {
+        Detail::ParallelFor(numElements > 0 ? numElements : 0, 256, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++)
+            {
+                const int val = input[i];
+                int firstIndex;
+#if CPU_REFERENCE_X86
+                if (level == SimdLevel::Avx512)
+                    firstIndex = Detail::FirstIndexAvx512(input, numElements, val);
+                else if (level == SimdLevel::Avx2)
+                    firstIndex = Detail::FirstIndexAvx2(input, numElements, val);
+                else
+#endif
+                    firstIndex = Detail::FirstIndexScalar(input, numElements, val);
+                output[i] = (firstIndex == (int)i) ? val : -1;
+            }
+        });
+    }
+
+    // fast duplicate removal: chunks sorted in parallel, merged, then adjacent duplicates dropped
+    // returns sorted unique elements (same result as RemoveDuplicatesCpu3 in duplicateRemoval.cpp)
+    inline std::vector<int> RemoveDuplicatesFast(std::vector<int> dup)
+    {
+        const size_t n = dup.size();
+        if (n == 0)
+            return dup;
+        const size_t grain = 1024 * 16;
+        const size_t hw = std::max(1u, std::thread::hardware_concurrency());
+        const size_t thr = std::max(size_t(1), std::min(hw, n / grain));
+        const size_t chunk = (n + thr - 1) / std::max(size_t(1), thr);
+
+        std::vector<size_t> bounds;
+        for (size_t b = 0; b < n; b += chunk)
+            bounds.push_back(b);
+        bounds.push_back(n);
+
+        Detail::ParallelFor(bounds.size() - 1, 1, [&](size_t begin, size_t end) {
+            for (size_t c = begin; c < end; c++)
+                std::sort(dup.begin() + bounds[c], dup.begin() + bounds[c + 1]);
+        });
+
+        // pairwise merge rounds, each round merges neighbor chunks in parallel
+        while (bounds.size() > 2)
+        {
+            const size_t pairs = (bounds.size() - 1) / 2;
+            Detail::ParallelFor(pairs, 1, [&](size_t begin, size_t end) {
+                for (size_t p = begin; p < end; p++)
+                    std::inplace_merge(dup.begin() + bounds[2 * p], dup.begin() + bounds[2 * p + 1], dup.begin() + bounds[2 * p + 2]);
+            });
+            std::vector<size_t> merged;
+            for (size_t b = 0; b < bounds.size(); b += 2)
+                merged.push_back(bounds[b]);
+            if (merged.back() != n)
+                merged.push_back(n);
+            bounds.swap(merged);
+        }
+
+        dup.erase(std::unique(dup.begin(), dup.end()), dup.end());
+        return dup;
+    }
+
+    // word-neighbor matrix, same output as findNeightbors kernel:
+    // matrix[i + j*numWords] = 1 if words i and j are within 1 letter difference, 0 otherwise, only for i<j
+    // (other elements are not written, same as kernel). words longer than maxWordLength letters are rejected
+    // runs with NeightborsSimdLevel(level), avx2 when cpu has avx512f without avx512bw
+    inline void FindNeightbors(const char* data, const int* start, const int* length, char* matrix, const int numWords, const SimdLevel level = BestSimdLevel())
+    {
+        if (numWords <= 0)
+            return;
+
+        std::vector<unsigned char> words((size_t)numWords * Detail::wordSlot, 0);
+        for (int i = 0; i < numWords; i++)
+        {
+            if (length[i] < 0 || length[i] > maxWordLength)
+                throw std::runtime_error(std::string("CpuReference::FindNeightbors: word ") + std::to_string(i) + " length " + std::to_string(length[i]) + " is outside of [0," + std::to_string(maxWordLength) + "]");
+            std::memcpy(words.data() + (size_t)i * Detail::wordSlot, data + start[i], length[i]);
+        }
+
+        // column j has j elements so chunks are small to keep threads balanced
+        const SimdLevel used = NeightborsSimdLevel(level);
+        Detail::ParallelFor(numWords, 64, [&](size_t begin, size_t end) {
+#if CPU_REFERENCE_X86
+            if (used == SimdLevel::Avx512)
+                Detail::NeighborColumnsAvx512(words.data(), length, matrix, numWords, begin, end);
+            else if (used == SimdLevel::Avx2)
+                Detail::NeighborColumnsAvx2(words.data(), length, matrix, numWords, begin, end);
+            else
+#endif
+                Detail::NeighborColumnsScalar(words.data(), length, matrix, numWords, begin, end);
+        });
+    }
+
+    // number of differing elements, for comparing kernel outputs against reference outputs
+    template<typename T>
+    size_t CountMismatches(const T* result, const T* reference, const size_t n)
+    {
+        size_t mismatches = 0;
+        for (size_t i = 0; i < n; i++)
+            mismatches += !(result[i] == reference[i]);
+        return mismatches;
+    }
+}
+
+#endif // CPU_REFERENCE_HPP
@@ -17,8 +17,15 @@ number of uniques after duplicate removal = 63247
 cpu duplicate removal multithreaded =0.0199999s
 number of uniques after duplicate removal = 63247
 -------------------------------------------------
+cpu duplicate removal (parallel sort) =(not measured yet on this system)
+number of uniques after duplicate removal = 63247
+-------------------------------------------------
+cpu duplicate removal brute-force O(N^2) avx512 =(not measured yet on this system)
+number of uniques after duplicate removal = 63247
+-------------------------------------------------
 gpu duplicate removal brute-force O(N^2)=0.0022068s
 number of uniques after duplicate removal = 63247
+gpu result matches cpu reference = yes
 -------------------------------------------------
 */
 
@@ -26,6 +33,8 @@ number of uniques after duplicate removal = 63247
 #include <fstream>
 
 #include "gpgpu.hpp"
+#include "cpuReference.hpp"
+#include "kernels.hpp"
 
 #include<random>
 #include<map>
@@ -173,44 +182,7 @@ struct GpuDuplicateRemover
     {
         try
         {
-            computer.compile(
-                R"(
-
-            kernel void findDuplicate(const global int * input, global int * output, const int numElements) 
-            { 
-                const int threadId=get_global_id(0); 
-                const int localThreadId = threadId % 256;
-         
-                const int val = ((threadId<numElements)?input[threadId]:-100000000);
-                local int cache[256];
-                int firstIndex = -1;
-                for(int i=0;i<numElements+512;i+=256)
-                {                   
-                    barrier(CLK_LOCAL_MEM_FENCE);
-                    if(i+localThreadId<numElements)
-                        cache[localThreadId] = input[i+localThreadId];
-                    else
-                        cache[localThreadId] = -1;
-                    barrier(CLK_LOCAL_MEM_FENCE);
-                    if(firstIndex == -1)
-                        for(int j=0;j<256;j++)
-                                firstIndex = ((val == cache[j])?(i+j):firstIndex);
-                }
-
-                if(threadId < numElements)
-                {
-                    if(threadId == firstIndex)
-                    {
-                        output[threadId]=val;
-                    }
-                    else
-                    {
-                        output[threadId]=-1;
-                    }
-                }
-            }
-
-            )", "findDuplicate");
+            computer.compile(Kernels::FindDuplicate(), "findDuplicate");
 
             input = computer.createArrayInput<int>("input", n);
             output = computer.createArrayOutputAll<int>("output", n);
@@ -313,6 +285,37 @@ int main()
     std::cout << "number of uniques after duplicate removal = " << numUndup4 << std::endl;
     std::cout << "-------------------------------------------------" << std::endl;
 
+    std::vector<int> cpuUnduplicated5;
+    // warming up
+    for (int i = 0; i < 10; i++)
+        cpuUnduplicated5 = CpuReference::RemoveDuplicatesFast(duplicates);
+    {
+        GPGPU::Bench bench(&t);
+        cpuUnduplicated5 = CpuReference::RemoveDuplicatesFast(duplicates);
+    }
+    std::cout << "cpu duplicate removal (parallel sort) =" << t / 1000000000.0f << "s" << std::endl;
+    int numUndup5 = cpuUnduplicated5.size();
+    std::cout << "number of uniques after duplicate removal = " << numUndup5 << std::endl;
+    std::cout << "-------------------------------------------------" << std::endl;
+
+    // same output as findDuplicate kernel, used for checking gpu result element by element
+    std::vector<int> cpuMarked(n);
+    // warming up
+    for (int i = 0; i < 10; i++)
+        CpuReference::FindDuplicate(duplicates.data(), cpuMarked.data(), n);
+    {
+        GPGPU::Bench bench(&t);
+        CpuReference::FindDuplicate(duplicates.data(), cpuMarked.data(), n);
+    }
+    std::vector<int> cpuUnduplicated6;
+    for (int i = 0; i < n; i++)
+        if (cpuMarked[i] >= 0)
+            cpuUnduplicated6.push_back(cpuMarked[i]);
+    std::cout << "cpu duplicate removal brute-force O(N^2) " << CpuReference::SimdLevelName(CpuReference::BestSimdLevel()) << " =" << t / 1000000000.0f << "s" << std::endl;
+    int numUndup6 = cpuUnduplicated6.size();
+    std::cout << "number of uniques after duplicate removal = " << numUndup6 << std::endl;
+    std::cout << "-------------------------------------------------" << std::endl;
+
     GpuDuplicateRemover gpu(n);
     std::vector<int> gpuUnduplicated;
     // warming up
@@ -323,8 +326,9 @@ int main()
         gpuUnduplicated = gpu.RemoveDuplicatesGpuBruteForce(duplicates);
     }
     std::cout << "gpu duplicate removal brute-force O(N^2)=" << t / 1000000000.0f << "s" << std::endl;
-    int numUndup5 = gpuUnduplicated.size();
-    std::cout << "number of uniques after duplicate removal = " << numUndup5 << std::endl;
+    int numUndup7 = gpuUnduplicated.size();
+    std::cout << "number of uniques after duplicate removal = " << numUndup7 << std::endl;
+    std::cout << "gpu result matches cpu reference = " << (gpuUnduplicated == cpuUnduplicated6 ? "yes" : "no") << std::endl;
     std::cout << "-------------------------------------------------" << std::endl;
     return 0;
 
@@ -0,0 +1,202 @@
+// OpenCL kernel sources used by the examples and benchmark.cpp
+// kept in one place so that a kernel fix in an example is also what the benchmark times
+
+#ifndef KERNELS_HPP
+#define KERNELS_HPP
+
+#include <string>
+#include <cstddef>
+
+#include "cpuReference.hpp"
+
+namespace Kernels
+{
+    // A[i] = B[i] + 1
+    inline std::string VecAdd()
+    {
+        return R"(
+
+            kernel void vecAdd(global int * A, const global int * B) 
+            { 
+                const int threadId=get_global_id(0); 
+                A[threadId] = B[threadId] + 1;
+            }
+
+        )";
+    }
+
+    // A[i] = B[i] + scalar
+    inline std::string VecAddScalar()
+    {
+        return R"(
+
+            kernel void vecAdd(global int * A, const global int * B, const int scalar) 
+            { 
+                const int threadId=get_global_id(0); 
+                A[threadId] = B[threadId] + scalar;
+            }
+
+        )";
+    }
+
+    // output[i] = input[i] for one representative of each value, -1 for other copies (brute-force O(N^2))
+    inline std::string FindDuplicate()
+    {
+        return R"(
+
+            kernel void findDuplicate(const global int * input, global int * output, const int numElements) 
+            { 
+                const int threadId=get_global_id(0); 
+                const int localThreadId = threadId % 256;
+         
+                const int val = ((threadId<numElements)?input[threadId]:-100000000);
+                local int cache[256];
+                int firstIndex = -1;
+                for(int i=0;i<numElements+512;i+=256)
+                {                   
+                    barrier(CLK_LOCAL_MEM_FENCE);
+                    if(i+localThreadId<numElements)
+                        cache[localThreadId] = input[i+localThreadId];
+                    else
+                        cache[localThreadId] = -1;
+                    barrier(CLK_LOCAL_MEM_FENCE);
+                    if(firstIndex == -1)
+                        for(int j=0;j<256;j++)
+                                firstIndex = ((val == cache[j])?(i+j):firstIndex);
+                }
+
+                if(threadId < numElements)
+                {
+                    if(threadId == firstIndex)
+                    {
+                        output[threadId]=val;
+                    }
+                    else
+                    {
+                        output[threadId]=-1;
+                    }
+                }
+            }
+
+        )";
+    }
+
+    // matrix[i + j*numWords] = 1 if words i<j are within 1 letter difference, 0 otherwise
+    inline std::string FindNeightbors(const int numWords)
+    {
+        return
+            "#define NUM_WORDS " + std::to_string(numWords) + R"(
+            )" +
+            "#define MAX_WORD_LENGTH " + std::to_string(CpuReference::maxWordLength) + R"(
+            )" +
+            R"(
+
+            kernel void findNeightbors( 
+                global char * data,
+                global int * start,
+                global int * length,
+                global char * matrix) 
+            { 
+                const int threadId=get_global_id(0); 
+                const int wStart1 = start[threadId];
+                const int wLength1 = length[threadId];
+                const int wEnd1 = wStart1+wLength1;
+                // assuming MAX_WORD_LENGTH (20) letters are enough for longest word
+                char localWord1[MAX_WORD_LENGTH];
+                char localWord2[MAX_WORD_LENGTH];
+
+                // load word1 into registers
+                for(int i=wStart1;i<wEnd1;i++)
+                {
+                    localWord1[i-wStart1]=data[i];
+                }
+    
+                for(int j=0;j<NUM_WORDS;j++)
+                {
+                    const int wStart2 = start[j];
+                    const int wLength2 = length[j];
+                    const int wEnd2 = wStart2+wLength2;
+                    // load word2 into local memory
+                    for(int i=wStart2;i<wEnd2;i++)
+                    {
+                        localWord2[i-wStart2]=data[i];
+                    }
+
+                    // compare
+                    const int nLow = wLength1 < wLength2 ? wLength1 : wLength2;
+                    int diff = abs(wLength1 - wLength2);
+                    for(int i=0;i<nLow;i++)
+                        diff += localWord1[i] != localWord2[i];
+
+                    // need to copy (i,j) to (j,i) later because they are same
+                    if(threadId<j)
+                    {
+                        if(diff>1)
+                        {
+                            matrix[threadId + j*NUM_WORDS]=0;
+                        }
+                        else
+                        {
+                            matrix[threadId + j*NUM_WORDS]=1;
+                        }
+                    }
+                }
+
+
+             }
+        )";
+    }
+
+    // n = number of ints per buffer, kernel runs with 1024*1024 threads
+    inline std::string Bandwidth(const size_t n, const bool testPCIE, const bool testREAD, const bool testWRITE)
+    {
+        return
+            "#define N_BUFFER "+std::to_string(n)+"ull" +R"(
+            )"+
+
+            "#define TEST_PCIE " + std::to_string(testPCIE) + R"(
+            )" +
+            "#define TEST_READ " + std::to_string(testREAD) + R"(
+            )" +
+            "#define TEST_WRITE " + std::to_string(testWRITE) + R"(
+            )" +
+
+            R"(
+
+            kernel void bandwidth( 
+                global int * data1,
+                global int * data2) 
+            { 
+                const int threadId=get_global_id(0); 
+
+                // in-kernel data copying to test only VRAM bandwidth
+                if(!TEST_PCIE)
+                {
+                    int data=0;
+                    if(TEST_READ && TEST_WRITE)
+                        for(int i=0;i<N_BUFFER;i+=1024*1024)
+                            data2[threadId + i]=data1[threadId + i];
+                    else if(TEST_READ && !TEST_WRITE)
+                    {
+                        for(int i=0;i<N_BUFFER;i+=1024*1024)
+                        {
+                            data^=data1[threadId + i];
+                        }
+                        data2[threadId]=data;
+                    }
+                    else if(!TEST_READ && TEST_WRITE)
+                        for(int i=0;i<N_BUFFER;i+=1024*1024)
+                            data2[threadId + i]=0;
+
+                    
+                }
+
+
+
+            }
+
+        )";
+    }
+}
+
+#endif // KERNELS_HPP
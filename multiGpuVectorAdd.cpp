@@ -5,6 +5,8 @@
 #include <fstream>
 
 #include "gpgpu.hpp"
+#include "cpuReference.hpp"
+#include "kernels.hpp"
 
 
 int main()
@@ -15,16 +17,7 @@ int main()
         const size_t n = 64;
 
         GPGPU::Computer computer(GPGPU::Computer::DEVICE_GPUS);
-        computer.compile(
-            R"(
-
-            kernel void vecAdd(global int * A, const global int * B) 
-            { 
-                const int threadId=get_global_id(0); 
-                A[threadId] = B[threadId] + 1;
-            }
-
-            )", "vecAdd");
+        computer.compile(Kernels::VecAdd(), "vecAdd");
 
         auto data1 =  computer.createArrayOutput<int>("A", n);
         auto data2 =  computer.createArrayInputLoadBalanced<int>("B", n);
@@ -36,6 +29,11 @@ int main()
             computer.compute(kernelParams, "vecAdd", 0, 64 /* kernel threads */, 4 /* block threads */);                                
             std::cout << data1.access<int>(15)<<std::endl;
         }
+
+        // cross-check all elements against cpu reference
+        std::vector<int> reference(n);
+        CpuReference::VecAdd(reference.data(), &data2.access<int>(0), n);
+        std::cout << "mismatches vs cpu reference = " << CpuReference::CountMismatches(&data1.access<int>(0), reference.data(), n) << std::endl;
     }
     catch (std::exception& ex)
     {
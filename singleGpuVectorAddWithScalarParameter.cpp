@@ -5,6 +5,8 @@
 #include <fstream>
 
 #include "gpgpu.hpp"
+#include "cpuReference.hpp"
+#include "kernels.hpp"
 
 
 int main()
@@ -15,16 +17,7 @@ int main()
         const size_t n = 64;
 
         GPGPU::Computer computer(GPGPU::Computer::DEVICE_GPUS,0/*select only first gpu*/);
-        computer.compile(
-            R"(
-
-            kernel void vecAdd(global int * A, const global int * B, const int scalar) 
-            { 
-                const int threadId=get_global_id(0); 
-                A[threadId] = B[threadId] + scalar;
-            }
-
-            )", "vecAdd");
+        computer.compile(Kernels::VecAddScalar(), "vecAdd");
 
         auto data1 =  computer.createArrayOutputAll<int>("A", n); // writes all results and assumes single gpu is used
         auto data2 =  computer.createArrayInput<int>("B", n); // loads all elements (broadcasts to all selected gpus)
@@ -38,6 +31,11 @@ int main()
             computer.compute(kernelParams, "vecAdd", 0, 64 /* kernel threads */, 4 /* block threads */);                                
             std::cout << data1.access<int>(15)<<std::endl;
         }
+
+        // cross-check all elements against cpu reference
+        std::vector<int> reference(n);
+        CpuReference::VecAdd(reference.data(), &data2.access<int>(0), 1000, n);
+        std::cout << "mismatches vs cpu reference = " << CpuReference::CountMismatches(&data1.access<int>(0), reference.data(), n) << std::endl;
     }
     catch (std::exception& ex)
     {